@@ -0,0 +1,89 @@
+#ifndef ASYNCIO_H
+#define ASYNCIO_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "error.h"
+using namespace std;
+
+// define to use the worker threads even where io_uring is available
+
+// #define NOURING
+
+// requests the asynchronous I/O layer keeps in flight at most
+#define AIODEPTH 64
+
+// worker threads doing the I/O when io_uring is not used
+#define AIOTHREADS 4
+
+struct IOBatch;  // requests submitted together, defined in asyncio.C
+
+// One read or write of consecutive pages of a file, from or into
+// buffers anywhere in memory.
+struct IORequest {
+    int fd;                   // unix file
+    bool write;               // write the buffers, else read into them
+    off_t offset;             // file offset of the first page
+    const struct iovec *iov;  // one buffer per page
+    int iovcnt;
+    Status status;   // OK or UNIXERR once the request has completed
+    IOBatch *batch;  // set by AsyncIO::run
+};
+
+// Asynchronous I/O layer beneath File. A batch of requests is started
+// at once, and the requests complete in any order. They go through
+// io_uring where the kernel supports it, and through a pool of worker
+// threads doing preadv and pwritev otherwise. Either way up to AIODEPTH
+// requests, of any number of threads, are in flight together. The
+// engine is only set up when the first batch is run.
+class AsyncIO {
+   public:
+    AsyncIO();
+    ~AsyncIO();
+
+    // runs the n requests and returns when all of them have completed:
+    // OK if all succeeded, else the status of the first that failed
+    const Status run(IORequest *requests, const int n);
+
+    const char *engine();  // "io_uring" or "threads"
+
+   private:
+    void start();      // set up the engine, with latch held
+    bool setupRing();  // false if the kernel has no io_uring
+    void queueRing(IORequest *request);
+    void enterRing(const int count);
+    void reapLoop();    // body of the thread completing io_uring requests
+    void workerLoop();  // body of the worker threads
+    void complete(IORequest *request, const ssize_t result);
+
+    mutex latch;  // protects everything below, and the batches in flight
+    bool started;
+    bool stopping;
+    int inflight;                 // requests submitted and not completed
+    condition_variable slotFree;  // inflight dropped below AIODEPTH
+
+    // the worker threads take their requests from queue
+    deque<IORequest *> queue;
+    condition_variable queued;
+    vector<thread> workers;
+
+    // io_uring: the submission queue is filled with latch held, the
+    // completion queue is only read by the reaper thread
+    bool uring;
+    int ringFd;
+    void *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    unsigned *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+    thread reaper;
+};
+
+#endif
@@ -1,28 +1,74 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #include "db.h"
+#include "page.h"
 // define if debug output wanted
 // #define DEBUGBUF
 
 // declarations for buffer pool hash table
 struct hashBucket {
-    File *file;        // pointer a file object (more on this below)
-    int pageNo;        // page number within a file
-    int frameNo;       // frame number of page in the buffer pool
-    hashBucket *next;  // next node in the hash table
+    File *file;   // pointer a file object (more on this below), NULL if the slot is empty
+    int pageNo;   // page number within a file
+    int frameNo;  // frame number of page in the buffer pool
 };
 
-// hash table to keep track of pages in the buffer pool
+// number of independently latched partitions of the buffer hash table
+#define BUFHASHSHARDS 16
+
+// hash table to keep track of pages in the buffer pool. It is split
+// into BUFHASHSHARDS shards, each with its own latch, so threads
+// looking up different pages rarely wait for each other. The caller
+// holds the latch of the shard of a page (see latch()) around every
+// operation on it.
+//
+// Each shard uses open addressing with linear probing in an array sized
+// for its share of the frames. A shard that gets more than its share,
+// beyond a load factor of 1/2, doubles its array; otherwise the arrays
+// are only reallocated when the buffer pool is resized.
 class BufHashTbl {
    private:
-    int HTSIZE;
-    hashBucket **ht;                               // actual hash table
-    int hash(const File *file, const int pageNo);  // returns value between 0 and HTSIZE-1
+    struct Shard {
+        mutex latch;
+        hashBucket *ht;  // actual hash table of the shard
+        int HTSIZE;      // slots in ht, always a power of 2
+        int count;       // pages in ht
+    };
+
+    Shard shards[BUFHASHSHARDS];                            // partitions of the table
+    unsigned int hash(const File *file, const int pageNo);  // full hash; shard from the high bits, slot from the low bits
+    static int shardNo(const unsigned int value) {
+        return (value >> 24) % BUFHASHSHARDS;
+    }
+    Shard &shardOf(const unsigned int value) {
+        return shards[shardNo(value)];
+    }
+    static int slotsFor(const int bufs);  // shard size for bufs frames
+    void rehash(Shard &shard, const int slots);  // move the shard into an array of slots
 
    public:
-    BufHashTbl(const int htSize);  // constructor
-    ~BufHashTbl();                 // destructor
+    BufHashTbl(const int bufs);  // constructor, bufs is the number of frames
+    ~BufHashTbl();               // destructor
+
+    // rehash every shard into an array sized for bufs frames, or for
+    // the pages it holds if they are more; takes the latches itself
+    void resize(const int bufs);
+
+    // latch of the shard holding (file,pageNo)
+    mutex &latch(const File *file, const int pageNo) {
+        return shards[shardNo(hash(file, pageNo))].latch;
+    }
 
     // insert entry into hash table mapping (file,pageNo) to frameNo;
     // returns 0 if OK, HASHTBLERROR if an error occurred
@@ -38,20 +84,81 @@ class BufHashTbl {
     Status remove(const File *file, const int pageNo);
 };
 
-class BufMgr;  // forward declaration of BufMgr class
+class BufMgr;     // forward declaration of BufMgr class
+class BufPolicy;  // forward declaration of BufPolicy class
+
+// frames in the ring of a large sequential scan, and of a bulk write
+// (load, sort run, partition)
+#define SCANRINGSIZE 8
+#define BULKRINGSIZE 4
+
+// pages a sequential scan has read ahead of it; less than SCANRINGSIZE - 1,
+// so a ring never recycles a prefetched page before the scan reads it
+#define PREFETCHDEPTH 4
+
+// The background writer wakes every BGWRITERDELAY milliseconds and
+// writes back at most BGWRITERMAXPAGES dirty pages among the
+// BGWRITERLOOKAHEAD percent of the frames the policy will replace next
+// (see BufMgr::setWriterRate)
+#define BGWRITERDELAY 10
+#define BGWRITERMAXPAGES 8
+#define BGWRITERLOOKAHEAD 25
+
+// frames the buffer pool needs at least: a join reads two relations
+// through scan rings and writes its result through a bulk write ring.
+// Smaller pools run out of frames in the middle of a query.
+#define MINBUFS (2 * SCANRINGSIZE + BULKRINGSIZE)
+
+// frames in the buffer pool of minirel unless it is started with another
+// number
+#define DEFAULTBUFS 100
+
+// frames the buffer pool can grow to (see BufMgr::resize), unless it is
+// constructed with more. Memory for them is only reserved, and used as
+// the pool grows.
+#define MAXBUFS 262144
+
+// Access strategy of an operator that reads or writes a file
+// sequentially. Instead of taking a frame from the replacement policy
+// for every page, it recycles a small ring of frames, so one large scan
+// or load cannot flush the rest of the buffer pool. A frame is only
+// recycled while it still holds the page the ring loaded into it, that
+// page is not pinned, and nobody else has read it since.
+class BufRing {
+    friend class BufMgr;
+
+   private:
+    static atomic<int> lastId;
+    int id;       // tag of the frames loaded through this ring
+    int size;     // number of slots
+    int *frames;  // frame of each slot, -1 if not used yet
+    int next;     // slot to recycle next
+    mutex latch;  // the ring is shared by a scan and its prefetches
+
+   public:
+    BufRing(const int ringSize);
+    ~BufRing();
+};
 
 // class for maintaining information about buffer pool frames
 class BufDesc {
     friend class BufMgr;
+    friend class BufPolicy;
 
    private:
-    File *file;   // pointer to file object
-    int pageNo;   // page within file
-    int frameNo;  // frame # of frame
-    int pinCnt;   // number of times this page has been pinned
-    bool dirty;   // true if dirty;  false otherwise
-    bool valid;   // true if page is valid
-    bool refbit;  // has this buffer frame been reference recently
+    atomic<File *> file;   // pointer to file object
+    atomic<int> pageNo;    // page within file
+    int frameNo;           // frame # of frame
+    atomic<int> pinCnt;    // number of times this page has been pinned
+    atomic<bool> dirty;    // true if dirty;  false otherwise
+    atomic<bool> valid;    // true if page is valid
+    atomic<int> ringId;    // ring that loaded the page, 0 if the page is shared
+    atomic<bool> prefetched;  // read ahead and not referenced since
+    atomic<long> lsn;         // LSN of the last log record of the page, 0 if none
+    atomic<bool> unlogged;    // changed while pinned and not logged since (see BufMgr::pageChanged)
+    int fileNext, filePrev;   // neighbours in the frame list of the file, -1 at the ends
+    mutex ioLatch;         // held while the page is being read into the frame
+    shared_mutex content;  // content latch of the page (see BufMgr::latchPage)
 
     void Clear() {  // initialize buffer frame for a new user
         pinCnt = 0;
@@ -59,6 +166,10 @@ class BufDesc {
         pageNo = -1;
         dirty = false;
         valid = false;
+        ringId = 0;
+        prefetched = false;
+        lsn = 0;
+        unlogged = false;
     };
 
     void Set(File *filePtr, int pageNum) {
@@ -67,59 +178,488 @@ class BufDesc {
         pinCnt = 1;
         dirty = false;
         valid = true;
-        refbit = true;
+        ringId = 0;
+        prefetched = false;
+        lsn = 0;
+        unlogged = false;
     }
 
     BufDesc() {
+        fileNext = filePrev = -1;
         Clear();
     }
 };
 
+// replacement policies the buffer manager can be constructed with
+enum ReplPolicy { ClockRepl, LRUKRepl, TwoQRepl, ARCRepl };
+
+// A page that is no longer in the buffer pool but whose recent use a
+// policy still remembers.
+struct GhostPage {
+    const File *file;
+    int pageNo;
+    long stamp;  // policy specific, e.g. time of the last reference
+};
+
+// FIFO of ghost pages, oldest first, holding at most maxSize pages.
+// The pages are also indexed by (file, pageNo), so finding or removing
+// one takes constant time.
+class GhostList {
+   private:
+    typedef pair<const File *, int> Key;
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return hash<const File *>()(key.first) ^ ((size_t)key.second * 0x9e3779b97f4a7c15ull);
+        }
+    };
+
+    list<GhostPage> pages;
+    unordered_map<Key, list<GhostPage>::iterator, KeyHash> index;  // position of each page
+    int maxSize;
+
+   public:
+    GhostList(const int size) : maxSize(size) {}
+
+    // remember a page, forgetting the oldest one if the list is full
+    void add(const File *file, const int pageNo, const long stamp);
+
+    // forget the page; returns true if it was in the list, and its stamp
+    bool remove(const File *file, const int pageNo, long &stamp);
+    bool contains(const File *file, const int pageNo) const;
+
+    void dropOldest() {
+        if (pages.empty()) return;
+        index.erase(Key(pages.front().file, pages.front().pageNo));
+        pages.pop_front();
+    }
+    void resize(const int size) {  // change maxSize, forgetting the oldest pages over it
+        maxSize = size;
+        while ((int)pages.size() > maxSize && !pages.empty()) dropOldest();
+    }
+    int size() const {
+        return pages.size();
+    }
+};
+
+// Doubly linked lists of frames, e.g. the queues of a policy, linked
+// through arrays indexed by frame so that appending, removing or moving
+// a frame takes constant time. A frame is in at most one of the lists.
+class FrameLists {
+   private:
+    int *next, *prev;  // neighbours of each frame, -1 at the ends
+    int *in;           // list of each frame, -1 if none
+    int *head, *tail;  // first and last frame of each list, -1 if it is empty
+    int *count;        // frames in each list
+
+   public:
+    FrameLists(const int lists, const int capacity);
+    ~FrameLists();
+
+    void append(const int which, const int frame);  // add frame at the end of list which
+    void remove(const int frame);                   // take frame out of its list, if any
+
+    int listOf(const int frame) const {  // list of frame, -1 if none
+        return in[frame];
+    }
+    int first(const int which) const {  // first frame of list which, -1 if empty
+        return head[which];
+    }
+    int after(const int frame) const {  // frame after frame in its list, -1 if last
+        return next[frame];
+    }
+    int size(const int which) const {
+        return count[which];
+    }
+};
+
+// Replacement policy of the buffer pool. The buffer manager tells the
+// policy about every page it loads into a frame, every hit, and every
+// frame it empties, and asks it for a frame whenever a page has to be
+// brought in. A policy should choose an invalid frame if there is one,
+// and must not choose a pinned frame. Frames are pinned concurrently,
+// so the buffer manager may not be able to use the frame; it reports
+// the eviction only once it has the frame, and otherwise asks again.
+//
+// The calls come from many threads. The clock policy only uses atomic
+// state; the others serialize their calls with latch.
+//
+// Empty frames are kept in a free list, so that a policy does not have
+// to search the pool for one. The buffer manager reports every frame it
+// empties with freed().
+class BufPolicy {
+   private:
+    mutex freeLatch;        // protects the free list
+    vector<int> freeList;   // frames emptied, some of them may be in use again
+    bool *listedFree;       // is the frame in freeList
+
+   protected:
+    const BufDesc *bufTable;  // frames of the buffer pool
+    atomic<int> numBufs;      // frames in use; the arrays of a policy have room for capacity
+    long now;     // logical time, advanced on every reference
+    mutex latch;  // protects the state of policies that are not lock free
+
+    bool isPinned(const int frame) const {
+        return bufTable[frame].pinCnt > 0;
+    }
+    bool isValid(const int frame) const {
+        return bufTable[frame].valid;
+    }
+    const File *fileOf(const int frame) const {
+        return bufTable[frame].file;
+    }
+    int pageOf(const int frame) const {
+        return bufTable[frame].pageNo;
+    }
+
+    // an unpinned invalid frame from the free list, -1 if there is none
+    int freeFrame();
+
+    // the first unpinned frame in list which, -1 if there is none
+    int firstUnpinned(const FrameLists &lists, const int which) const;
+
+    // append to frames, from n on, the unpinned frames holding pages in
+    // list which, in list order, up to max frames in all; returns the
+    // new number of frames
+    int unpinnedInOrder(const FrameLists &lists, const int which, int *frames, int n, const int max) const;
+
+   public:
+    BufPolicy(const BufDesc *table, const int bufs, const int capacity);
+    virtual ~BufPolicy();
+
+    // frame is empty now: its page was disposed, flushed or could not be
+    // read, the frame was not used after all, or the pool grew by it
+    void freed(const int frame);
+
+    virtual const char *name() const = 0;
+
+    // choose the frame page (file, pageNo) is read into. Returns
+    // BUFFEREXCEEDED if all frames are pinned
+    virtual const Status pickVictim(const File *file, const int pageNo, int &frame) = 0;
+
+    // the page in frame, chosen by pickVictim(), has been evicted
+    virtual void evicted(const int frame) = 0;
+
+    // page (file, pageNo) has been loaded into frame
+    virtual void loaded(const int frame, const File *file, const int pageNo) = 0;
+
+    // the page in frame was found in the buffer pool
+    virtual void accessed(const int frame) = 0;
+
+    // frame was emptied otherwise (page disposed, file flushed, frame
+    // recycled by a ring)
+    virtual void removed(const int frame) = 0;
+
+    // fill frames with up to max unpinned frames holding pages, in the
+    // order they would be replaced, without changing the state of the
+    // policy. Returns the number of frames found
+    virtual int nextVictims(int *frames, const int max) = 0;
+
+    // the pool now has bufs frames. When it shrinks, the frames cut off
+    // are empty; frames added are empty too
+    virtual void resize(const int bufs) = 0;
+
+    static BufPolicy *create(const ReplPolicy policy, const BufDesc *table, const int bufs, const int capacity);
+};
+
+// The clock algorithm: a hand sweeps over the frames, giving every
+// frame whose reference bit is set a second chance.
+class ClockPolicy : public BufPolicy {
+   private:
+    atomic<unsigned int> clockHand;
+    atomic<bool> *refbit;  // has this buffer frame been referenced recently
+
+   public:
+    ClockPolicy(const BufDesc *table, const int bufs, const int capacity);
+    ~ClockPolicy();
+    const char *name() const {
+        return "clock";
+    }
+    const Status pickVictim(const File *file, const int pageNo, int &frame);
+    void evicted(const int frame);
+    void loaded(const int frame, const File *file, const int pageNo);
+    void accessed(const int frame);
+    void removed(const int frame);
+    int nextVictims(int *frames, const int max);
+    void resize(const int bufs);
+};
+
+// LRU-K with K = 2 (O'Neil et al.): evicts the page whose second to
+// last reference is oldest. Pages referenced only once are evicted
+// first, in LRU order, so a sequential scan cannot flush pages that are
+// used repeatedly. The references of evicted pages are remembered for a
+// while, so a page read again soon keeps its history.
+class LRUKPolicy : public BufPolicy {
+   private:
+    long *last;  // time of the last reference of the page in each frame, 0 if none
+    long *prev;  // time of the reference before that, 0 if none
+    set<tuple<long, long, int>> order;  // (prev, last, frame) of each page, in eviction order
+    GhostList history;
+
+    void unlink(const int frame);
+
+   public:
+    LRUKPolicy(const BufDesc *table, const int bufs, const int capacity);
+    ~LRUKPolicy();
+    const char *name() const {
+        return "LRU-2";
+    }
+    const Status pickVictim(const File *file, const int pageNo, int &frame);
+    void evicted(const int frame);
+    void loaded(const int frame, const File *file, const int pageNo);
+    void accessed(const int frame);
+    void removed(const int frame);
+    int nextVictims(int *frames, const int max);
+    void resize(const int bufs);
+};
+
+// 2Q (Johnson and Shasha): new pages enter the FIFO A1in; only pages
+// that are referenced again after leaving it, while they are still
+// remembered in the ghost queue A1out, are promoted to the LRU queue
+// Am of hot pages.
+class TwoQPolicy : public BufPolicy {
+   private:
+    enum { A1IN, AM };
+    FrameLists queues;  // A1in in FIFO order, Am in LRU order
+    int a1inMax;        // target size of A1in
+    GhostList a1out;
+
+   public:
+    TwoQPolicy(const BufDesc *table, const int bufs, const int capacity);
+    ~TwoQPolicy();
+    const char *name() const {
+        return "2Q";
+    }
+    const Status pickVictim(const File *file, const int pageNo, int &frame);
+    void evicted(const int frame);
+    void loaded(const int frame, const File *file, const int pageNo);
+    void accessed(const int frame);
+    void removed(const int frame);
+    int nextVictims(int *frames, const int max);
+    void resize(const int bufs);
+};
+
+// ARC (Megiddo and Modha): pages referenced once (T1) and more than
+// once (T2) are kept in separate LRU lists, and the ghost lists B1 and
+// B2 of pages recently evicted from each adapt the target size of T1
+// to the workload.
+class ARCPolicy : public BufPolicy {
+   private:
+    enum { T1, T2 };
+    FrameLists lists;  // T1 and T2, each in LRU order
+    int target;        // target size of T1
+    GhostList b1, b2;
+
+    const Status replace(const bool inB2, int &frame);
+    void trimGhosts();
+
+   public:
+    ARCPolicy(const BufDesc *table, const int bufs, const int capacity);
+    ~ARCPolicy();
+    const char *name() const {
+        return "ARC";
+    }
+    const Status pickVictim(const File *file, const int pageNo, int &frame);
+    void evicted(const int frame);
+    void loaded(const int frame, const File *file, const int pageNo);
+    void accessed(const int frame);
+    void removed(const int frame);
+    int nextVictims(int *frames, const int max);
+    void resize(const int bufs);
+};
+
 struct BufStats {
-    int accesses;    // Total number of accesses to buffer pool
-    int diskreads;   // Number of pages read from disk (including allocs)
-    int diskwrites;  // Number of pages written back to disk
+    const char *policy;  // Name of the replacement policy
+    int accesses;        // Total number of accesses to buffer pool
+    int hits;            // Number of page reads found in the buffer pool
+    int misses;          // Number of page reads that had to go to disk
+    int diskreads;       // Number of pages read from disk (including allocs)
+    int diskwrites;      // Number of pages written back to disk
+    int syncwrites;      // Number of them written to free a frame for a read
+    int bgwrites;        // Number of them written by the background writer
+    int ringreuses;      // Number of frames recycled by access rings
+    int prefetches;      // Number of pages read ahead of a scan
 
+    // The background threads of the buffer manager may be counting
+    // while the statistics are cleared or read.
     void clear() {
-        accesses = diskreads = diskwrites = 0;
+        int *stats[] = {&accesses, &hits, &misses, &diskreads, &diskwrites, &syncwrites, &bgwrites, &ringreuses, &prefetches};
+        for (int *stat : stats) __atomic_store_n(stat, 0, __ATOMIC_RELAXED);
+    }
+
+    BufStats snapshot() const {
+        BufStats copy;
+        copy.policy = policy;
+        const int *from[] = {&accesses, &hits, &misses, &diskreads, &diskwrites, &syncwrites, &bgwrites, &ringreuses, &prefetches};
+        int *to[] = {&copy.accesses, &copy.hits, &copy.misses, &copy.diskreads, &copy.diskwrites, &copy.syncwrites, &copy.bgwrites, &copy.ringreuses, &copy.prefetches};
+        for (int i = 0; i < 9; i++) *to[i] = __atomic_load_n(from[i], __ATOMIC_RELAXED);
+        return copy;
     }
 
     BufStats() {
+        policy = "";
         clear();
     }
 };
 
 class BufMgr {
    private:
-    unsigned int clockHand;
-    int numBufs;            // Number of pages in buffer pool
+    atomic<int> numBufs;    // Number of pages in buffer pool
+    int capacity;           // Number of frames the pool can grow to
+    int constructed;        // Number of frames whose BufDesc is constructed
     BufHashTbl *hashTable;  // hash table mapping (File, page) to frame
     BufDesc *bufTable;      // vector of status info, 1 per page
+    BufPolicy *policy;      // chooses the frames to replace
     BufStats bufStats;      // buffer pool statistics
 
-    const Status allocBuf(int &frame);  // allocate a free frame.
-    const void releaseBuf(int frame);   // return unused frame to end of list
-    void advanceClock() {
-        clockHand = (clockHand + 1) % numBufs;
+    // allocate a frame for page (file, pageNo), from the ring if given.
+    // The frame is returned pinned once, invalid and not in the hash
+    // table. When reading ahead, gives up instead of waiting for frames
+    // to be unpinned
+    const Status allocBuf(const File *file, const int pageNo, BufRing *ring, int &frame,
+                          const bool readingAhead = false);
+    const void releaseBuf(int frame);  // return unused frame to end of list
+
+    // The frames holding pages of each file are kept in a list, linked
+    // through BufDesc::fileNext and filePrev, so that flushing or closing
+    // a file costs as much as the pages it has in the pool. A frame is
+    // linked once its page is in the hash table and unlinked before the
+    // page leaves it.
+    unordered_map<const File *, int> fileFrames;  // first frame of each file
+    mutex fileFramesLatch;                        // protects the lists
+    void linkFrame(const int frame);              // add frame to the list of its file
+    void unlinkFrame(const int frame);            // remove frame from the list of its file
+    void framesOf(const File *file, vector<int> &frames);
+
+    // write the pages in the n frames back to disk, in file and page
+    // order, each run of consecutive pages of a file with one write and
+    // all writes in flight at once. Holds their content latches shared
+    // meanwhile, unless the caller does (latched)
+    const Status writeBack(const int *frames, const int n, const bool latched = false);
+
+    // Write-ahead logging: a page is logged whenever it is unpinned
+    // dirty, and the log is forced up to the frame's LSN before the page
+    // is written back.
+    const Status logFrame(const int frame);  // log the pinned page in frame
+    const Status writeFrame(const int frame);  // force the log, then write the page in frame
+
+    // frames marked by pageChanged, logged at the next commit
+    mutex unloggedLatch;
+    vector<int> unloggedFrames;
+
+    // pin frame if nobody else has it pinned
+    bool claimBuf(const int frame) {
+        int unpinned = 0;
+        return bufTable[frame].pinCnt.compare_exchange_strong(unpinned, 1);
     }
 
+    // readPage() for both callers and the prefetcher; prefetches are
+    // not counted as references
+    const Status fetchPage(File *file, const int PageNo, Page *&page, BufRing *ring, const bool prefetching);
+
+    // Read-ahead requests are served one at a time by a thread of the
+    // buffer manager.
+    struct PrefetchRequest {
+        File *file;
+        int pageNo;      // page the chain is followed from
+        int depth;       // number of pages to read ahead
+        BufRing *ring;   // ring of the scan, NULL if none
+    };
+    deque<PrefetchRequest> prefetchQueue;
+    mutex prefetchLatch;                 // protects the queue, prefetchFile and stopping
+    condition_variable prefetchReady;    // signalled when a request is queued
+    condition_variable prefetchDone;     // signalled when a request is served
+    const File *prefetchFile;            // file of the request being served, NULL if none
+    bool stopping;                       // the prefetcher should exit
+    thread prefetcher;
+    void prefetchLoop();
+    // read the pages in use from pageNo on in file, up to count of them
+    // and up to the first one in the pool already, with one request
+    void readRun(File *file, const int pageNo, const int count, BufRing *ring);
+    mutex readAheadLatch;  // held while readRun has frames pinned
+
+    // The background writer writes dirty pages back before the policy
+    // picks them as victims, so that a read rarely has to wait for a
+    // write. A round of writes holds writerLatch.
+    mutable mutex writerLatch;        // protects the settings below
+    condition_variable writerWake;    // wakes the writer early
+    int writerDelay;                  // milliseconds between rounds
+    int writerMaxPages;               // pages written per round, 0 to stop writing
+    bool writerStopping;              // the writer should exit
+    thread writer;
+    void writerLoop();
+
+    mutex resizeLatch;  // serializes resize()
+
    public:
-    Page *bufPool;  // actual buffer pool
+    char *bufPool;  // actual buffer pool, pageSize bytes per frame
+
+    // the page in frame frameNo, and the frame holding page
+    Page *framePage(const int frameNo) const { return (Page *)(bufPool + (size_t)frameNo * pageSize); }
+    int pageFrame(const Page *page) const { return ((const char *)page - bufPool) / pageSize; }
 
-    BufMgr(const int bufs);
+    BufMgr(const int bufs, const ReplPolicy repl = ClockRepl, const int maxBufs = MAXBUFS);
     ~BufMgr();
 
-    const Status readPage(File *file, const int PageNo, Page *&page);
+    // Change the number of frames to bufs, at least MINBUFS and at most
+    // the capacity the pool was constructed with, while it is in use;
+    // returns BADBUFSIZE for other sizes. Growing adds empty
+    // frames. Shrinking evicts the pages in the frames cut off, writing
+    // back dirty ones, and fails with PAGEPINNED, leaving the size as it
+    // was, if any of them is pinned.
+    const Status resize(const int bufs);
+
+    // The ring, if given, is the access strategy of a sequential reader
+    // or writer (see BufRing).
+    const Status readPage(File *file, const int PageNo, Page *&page, BufRing *ring = NULL);
     const Status unPinPage(File *file, const int PageNo, const bool dirty);
-    const Status allocPage(File *file, int &PageNo, Page *&page);
-    // allocates a new, empty page
+    // allocates a new, empty page, near the page near if one is free
+    // there (see File::allocatePage)
+    const Status allocPage(File *file, int &PageNo, Page *&page, BufRing *ring = NULL, const int near = -1);
     const Status flushFile(const File *file);                // writing out all dirty pages of the file
+    // write back every dirty page, pinned ones too, keeping them in the
+    // pool; for a checkpoint, between statements
+    const Status flushAll();
+    // A page pinned across statements, e.g. a heap file's header page,
+    // was changed. Such pages are otherwise only logged once they are
+    // unpinned dirty; logChangedPages logs those changed since they were
+    // last logged, at the end of a statement.
+    void pageChanged(const Page *page);
+    const Status logChangedPages();
+    // Read the depth pages that follow PageNo in the page chain of file
+    // into the buffer pool in the background, through the scan's ring
+    // if given. A newer request of the same scan replaces a queued one.
+    void prefetch(File *file, const int PageNo, const int depth, BufRing *ring = NULL);
+    // drop the read-ahead requests on file and wait for the one being
+    // served; called before a file is closed or its scan's ring is freed
+    void stopPrefetch(const File *file);
+    // limit the background writer to maxPages pages every delay
+    // milliseconds; maxPages 0 turns it off
+    void setWriterRate(const int delay, const int maxPages);
     const Status disposePage(File *file, const int PageNo);  // dispose of page in file
+    // Take n frames out of the pool for memory an operator allocates
+    // itself, e.g. a hash table whose tuples stand in for pages the
+    // pool would otherwise hold. The frames stay pinned and empty until
+    // releaseFrames gives them back.
+    const Status reserveFrames(const int n, vector<int> &frames);
+    void releaseFrames(vector<int> &frames);
     void printSelf();
 
-    const BufStats &getBufStats() const  // get buffer pool usage
+    // The buffer manager is safe to use from several threads. A pin
+    // keeps a page in its frame, but does not keep other threads from
+    // changing it: threads that share a page latch its contents, shared
+    // to read and exclusive to change them. page must be pinned.
+    void latchPage(const Page *page, const bool exclusive);
+    void unlatchPage(const Page *page, const bool exclusive);
+
+    const int numUnpinnedPages() const;  // number of frames nobody has pinned
+
+    const int getNumBufs() const {  // number of frames in the pool
+        return numBufs;
+    }
+
+    const BufStats getBufStats() const  // get buffer pool usage
     {
-        return bufStats;
+        return bufStats.snapshot();
     }
     const void clearBufStats() {
         bufStats.clear();
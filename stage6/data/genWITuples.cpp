@@ -1,5 +1,13 @@
 //=============================================================================
 // Generate simple WI Tuple unique1 tuples
+//
+// With the optional zipf arguments the values are not unique but drawn
+// from <num keys> distinct keys (0 .. num keys - 1) with a Zipf
+// distribution: key k is chosen with probability proportional to
+// 1 / (k + 1)^skew, so key 0 is the most frequent one. A skew of 0
+// gives uniformly distributed keys. With a tuple size as well, each
+// value is followed by blanks up to that many bytes, so that fewer
+// tuples fit on a page.
 //=============================================================================
 
 #include <string.h>
@@ -10,61 +18,113 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
 
 #define NUMRANDOMIZEPASSES 10
 
 int main(int argc, char *argv[])
 {
     // get command line args
-    if (argc != 3)
+    if (argc != 3 && argc != 5 && argc != 6)
     {
         fprintf(stderr, 
-                "Usage: %s <total num tuples> <output filename>\n",
+                "Usage: %s <total num tuples> <output filename> "
+                "[<zipf skew> <num keys> [<tuple size>]]\n",
                 argv[0]);
         return 1;
     }
     int tupleCount = atoi(argv[1]);
     char *outputFilename = argv[2];
+    int tupleSize = argc == 6 ? atoi(argv[5]) : sizeof(int);
+    if (tupleSize < (int)sizeof(int))
+    {
+        fprintf(stderr, "Tuple size must be at least %d\n", (int)sizeof(int));
+        return 1;
+    }
 
     // gen the tuples
     int nums[tupleCount];
+    srand(time(NULL));
 
-    // fill in in order
-    for (int i = 0; i < tupleCount; i++)
+    if (argc >= 5)
     {
-        nums[i] = i;
+        double skew = atof(argv[3]);
+        int keyCount = atoi(argv[4]);
+        if (keyCount < 1)
+        {
+            fprintf(stderr, "Number of keys must be positive\n");
+            return 1;
+        }
+
+        // cumulative distribution of the keys
+        double *cdf = new double[keyCount];
+        double sum = 0.0;
+        for (int k = 0; k < keyCount; k++)
+        {
+            sum += 1.0 / pow(k + 1, skew);
+            cdf[k] = sum;
+        }
+
+        // draw each value by binary search of a uniform number in the
+        // distribution
+        for (int i = 0; i < tupleCount; i++)
+        {
+            double u = sum * rand() / ((double)RAND_MAX + 1);
+            int lo = 0, hi = keyCount - 1;
+            while (lo < hi)
+            {
+                int mid = (lo + hi) / 2;
+                if (cdf[mid] <= u)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            nums[i] = lo;
+        }
+        delete [] cdf;
     }
-    // randomize
-    srand(time(NULL));
-    for (int pass = 0; pass < NUMRANDOMIZEPASSES; pass++)
+    else
     {
+        // fill in in order
         for (int i = 0; i < tupleCount; i++)
         {
-            // swap curr entry to new pos
-            int newPos = rand() % tupleCount;
-            int tmpVal = nums[newPos];
-            nums[newPos] = nums[i];
-            nums[i] = tmpVal; 
+            nums[i] = i;
+        }
+        // randomize
+        for (int pass = 0; pass < NUMRANDOMIZEPASSES; pass++)
+        {
+            for (int i = 0; i < tupleCount; i++)
+            {
+                // swap curr entry to new pos
+                int newPos = rand() % tupleCount;
+                int tmpVal = nums[newPos];
+                nums[newPos] = nums[i];
+                nums[i] = tmpVal; 
+            }
         }
     }
 
     // write the tuples to the output file
-    int outfd = open(outputFilename, O_WRONLY | O_CREAT | O_TRUNC);
+    int outfd = open(outputFilename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
     if (-1 == outfd)
     {
         perror("Error opening file for writing\n");
         exit(1);
     }
     // write the tuples
+    char *tuple = new char[tupleSize];
+    memset(tuple, ' ', tupleSize);
     for (int i = 0; i < tupleCount; i++)
     {
-        if (write(outfd, &nums[i], sizeof(int)) == -1)
+        memcpy(tuple, &nums[i], sizeof(int));
+        if (write(outfd, tuple, tupleSize) == -1)
         {
             perror("Error writing tuple\n");
             return 1;
         }
     }
         
+    delete [] tuple;
     close(outfd);
     printf("Done.\n");
     return 0;
@@ -2,8 +2,13 @@
 #define DB_H
 
 #include <sys/types.h>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <vector>
 #include "error.h"
+#include "asyncio.h"
+#include "wal.h"
 #include <string.h>
 using namespace std;
 
@@ -12,8 +17,39 @@ using namespace std;
 // #define DEBUGIO
 // #define DEBUGFREE
 
+// files kept open, with their pages in the buffer pool, after their
+// last close (see DB::closeFile)
+#define FILECACHESIZE 16
+
+// pages a file grows by at once when it runs out of room
+#define FILEEXTENT 64
+
+// layout of the DB header, free-space map and data pages. Format 2
+// records the page size and widens the slots of data pages; files of
+// older formats cannot be opened.
+#define DBFORMAT 2
+
 // forward class definition for db
 class DB;
+class File;
+
+// structure of DB (header) page
+
+typedef struct {
+    int freeMap;    // page # of first free-space map page, -1 if none
+    int firstPage;  // page # of first page in file
+    int numPages;   // total # of pages in file
+    int format;     // DBFORMAT
+    int pageSize;   // bytes of every page of the file
+} DBPage;
+
+// One page of a batch of reads and writes (see File::transfer).
+struct PageIO {
+    File *file;
+    int pageNo;
+    Page *page;  // read into, or written from, here
+    bool write;
+};
 
 // class definition for open files
 class File {
@@ -21,7 +57,9 @@ class File {
     friend class OpenFileHashTbl;
 
    public:
-    Status allocatePage(int &pageNo);            // allocate a new page
+    // allocate a new page, the free one nearest after near if there is
+    // one, e.g. the last page of a relation to keep its pages together
+    Status allocatePage(int &pageNo, const int near = -1);
     const Status disposePage(const int pageNo);  // release space for a page
     const Status readPage(const int pageNo,
                           Page *pagePtr) const;  // read page from file
@@ -29,6 +67,23 @@ class File {
                            const Page *pagePtr);   // write page to file
     const Status getFirstPage(int &pageNo) const;  // returns pageNo of first page
 
+    // number of pages from pageNo on, up to max, that are in use, i.e.
+    // allocated and not part of the free-space map
+    int usedRun(const int pageNo, const int max) const;
+
+    // Read or write the n pages, of files of the same DB, all at once:
+    // every run of consecutive pages of a file is one request to the
+    // asynchronous I/O layer, and all requests are in flight together.
+    // Sorted by file and page number, the pages make the longest runs.
+    static const Status transfer(const PageIO *pages, const int n);
+
+    // Log the image of a page changed in the buffer pool, and force the
+    // log up to lsn before such a page is written back. Both do nothing
+    // for files of a DB without a log; logPage then returns lsn 0.
+    const Status logPage(const int pageNo, const Page *pagePtr, long &lsn);
+    const Status forceLog(const long lsn);
+    bool logged() const { return log != NULL; }  // the DB of the file has a log
+
     bool operator==(const File &other) const {
         return fileName == other.fileName;
     }
@@ -42,11 +97,33 @@ class File {
 
     const Status open();
     const Status close();
+    const Status release();  // flush the pages of the file and close it for real
+    const Status sync();     // write the header and free-space map back, and fsync
 
     const Status intread(const int pageNo,
                          Page *pagePtr) const;  // internal file read
     const Status intwrite(const int pageNo,
                           const Page *pagePtr);  // internal file write
+    const Status writeHeader();               // write the cached header back if it changed
+    const Status extend();                    // make room for FILEEXTENT more pages
+
+    const Status readFreeMap();   // load the free-space map
+    const Status writeFreeMap();  // store the free-space map if it changed
+    bool isFree(const int pageNo) const {
+        return freeBits[pageNo >> 3] & (1 << (pageNo & 7));
+    }
+    void setBit(const int pageNo, const bool free) {
+        if (free)
+            freeBits[pageNo >> 3] |= 1 << (pageNo & 7);
+        else
+            freeBits[pageNo >> 3] &= ~(1 << (pageNo & 7));
+    }
+    void setFree(const int pageNo, const bool free);
+    int findFree(const int near) const;  // a free page, or -1
+
+    // replay allocation and disposal records of the log
+    const Status redoAlloc(const int pageNo, const int count);
+    void redoFree(const int pageNo, const int count);
 
 #ifdef DEBUGFREE
     void listFree();  // list free pages
@@ -55,6 +132,27 @@ class File {
     string fileName;  // The name of the file
     int openCnt;      // # times file has been opened
     int unixFile;     // unix file stream for file
+    AsyncIO *io;      // I/O layer of the DB the file belongs to
+    LogMgr *log;      // log of the DB, NULL if it has none
+
+    // The header page is read when the file is opened and kept here; it
+    // is only written back when the file is released. The unix file
+    // grows by FILEEXTENT pages at a time, so it usually has room for
+    // more pages than the header counts.
+    DBPage header;
+    bool headerDirty;     // header changed since it was last written
+    int extentEnd;        // pages the unix file has room for
+
+    // Free pages are found in a bitmap, with a bit per page that is set
+    // while the page is free. It is kept in memory too, and stored
+    // along with the header in a chain of map pages, each starting with
+    // the number of the next one.
+    vector<unsigned char> freeBits;
+    int freeCnt;           // bits set in freeBits
+    vector<int> mapPages;  // the map pages, in chain order
+    bool mapDirty;         // freeBits changed since they were last written
+
+    mutable mutex latch;  // protects the header, extentEnd and the free-space map
 };
 
 class BufMgr;
@@ -88,6 +186,9 @@ class OpenFileHashTbl {
 
     // returns OK if fileName was found.  Else return HASHTBLERROR
     Status erase(const string fileName);
+
+    // append all files in the table to files
+    void list(vector<File *> &files);
 };
 
 class DB {
@@ -100,17 +201,38 @@ class DB {
                                                                  // release all space
     const Status openFile(const string &fileName, File *&file);  // open a file
     const Status closeFile(File *file);                          // close a file
+    const Status closeCachedFiles();                             // close the files kept open
+
+    // Set the page size of the database, a power of 2 from MINPAGESIZE
+    // to MAXPAGESIZE. It must be set before the buffer manager is
+    // created and any file is opened. Returns BADPAGESIZE otherwise.
+    const Status setPageSize(const int size);
+    // set the page size to that of an existing file of the database
+    const Status readPageSize(const string &fileName);
+
+    // Open the write-ahead log of the database in the current
+    // directory, first recovering the files from it. Until then
+    // changes are not logged.
+    const Status openLog();
+    // End a statement: its changes are durable once this returns. Also
+    // takes a checkpoint when the log has grown too large.
+    const Status commit();
+    // write all changed pages and file headers back and empty the log
+    const Status checkpoint();
 
    private:
+    AsyncIO io;                 // asynchronous I/O beneath the files, outlives them
+    LogMgr log;                 // write-ahead log, outlives the files too
+    bool logging;               // log is open
+    const Status recover();     // replay the log
+    const Status syncFiles();   // fsync the open files and the directory
     OpenFileHashTbl openFiles;  // list of open files
-};
 
-// structure of DB (header) page
-
-typedef struct {
-    int nextFree;   // page # of next page on free list
-    int firstPage;  // page # of first page in file
-    int numPages;   // total # of pages in file
-} DBPage;
+    // Files nobody has open any more, least recently closed first. They
+    // stay in openFiles, so reopening one finds its pages still in the
+    // buffer pool.
+    deque<File *> closedFiles;
+    const Status dropFile(File *file);  // close a file of closedFiles for real
+};
 
 #endif
@@ -26,6 +26,8 @@ enum Status {
     BADPAGEPTR,
     BADPAGENO,
     FILEEXISTS,
+    BADPAGESIZE,
+    BADFORMAT,
 
     // BufMgr and HashTable errors
 
@@ -35,6 +37,7 @@ enum Status {
     PAGENOTPINNED,
     BADBUFFER,
     PAGEPINNED,
+    BADBUFSIZE,
 
     // Page errors
 
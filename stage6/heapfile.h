@@ -44,6 +44,7 @@ class HeapFile {
     int curPageNo;      // page number of pinned page
     bool curDirtyFlag;  // true if page has been updated
     RID curRec;         // rid of last record returned
+    BufRing *ring;      // access strategy of sequential reads and writes, NULL if none
 
    public:
     // initialize
@@ -55,8 +56,27 @@ class HeapFile {
     // return number of records in file
     const int getRecCnt() const;
 
+    // return number of data pages in file
+    const int getPageCnt() const;
+
+    // return page number of the i-th data page (0 <= i < getPageCnt()),
+    // or -1 if the data pages of the file are not numbered contiguously
+    const int getDataPageNo(const int i) const;
+
     // given a RID, read record from file, returning pointer and length
     const Status getRecord(const RID &rid, Record &rec);
+
+    // pin an additional page of the file in the buffer pool, and
+    // release it again (used by operators that hold blocks of pages)
+    const Status pinPage(const int pageNo, Page *&page);
+    const Status unpinPage(const int pageNo);
+
+    // read and write the pages of the file sequentially through a ring
+    // of the given number of buffer frames (see BufRing)
+    void setRing(const int frames);
+
+   protected:
+    void headerChanged();  // set hdrDirtyFlag, and have the header page logged
 };
 
 class HeapFileScan : public HeapFile {
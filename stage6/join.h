@@ -0,0 +1,96 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include "catalog.h"
+#include "query.h"
+
+// Internal interface shared by the join methods (join.C, hashjoin.C).
+
+// define if debug output wanted
+// #define DEBUGJOIN
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// frames kept free by the hash joins so that the result relation can
+// allocate new pages while a block of build pages is pinned
+#define HJRESERVE 2
+
+// Where a join method puts its result tuples: the projection list,
+// the open result relation and the number of tuples written so far.
+struct JoinOutput {
+    InsertFileScan *resultRel;      // result relation
+    int projCnt;                    // number of projected attributes
+    const AttrDesc *attrDescArray;  // projected attributes
+    const AttrDesc *outerAttr;      // join attribute of the outer relation
+    Record outputRec;               // buffer for the result tuple
+    int tupCnt;                     // number of result tuples produced
+};
+
+// build the result tuple of a matching (outer, inner) pair and insert
+// it into the result relation
+const Status emitJoinTuple(JoinOutput &out, const Record &outerRec, const Record &innerRec);
+
+// compare two join attribute values; returns < 0, 0 or > 0 like strcmp
+const int compareAttr(const char *attr1, const char *attr2, const int attrType, const int attrLen);
+
+// operator for the same predicate with the operands swapped
+const Operator mirrorOp(const Operator op);
+
+// look up the projected attributes and the join attributes in the
+// catalog and compute the length of a result tuple
+const Status getJoinInfo(const int projCnt, const attrInfo projNames[], const attrInfo *attr1,
+                         const attrInfo *attr2, AttrDesc attrDescArray[], AttrDesc &attrDesc1, AttrDesc &attrDesc2,
+                         int &reclen);
+
+// tuple width of a relation (from the catalog)
+const Status getTupleWidth(const string &relation, int &width);
+
+// record and page counts of a heap file
+const Status getFileSize(const string &fileName, int &recCnt, int &pageCnt);
+
+// number of tuples of the given width that fit on a data page
+const int tuplesPerPage(const int width);
+
+// Equi-join of two heap files: blocks of the build file are hashed in
+// memory and probed with one scan of the probe file per block. The
+// files need not be relations (they can be partitions); buildIsOuter
+// tells which one holds the outer relation's tuples.
+const Status blockHashJoin(const string &buildFile, const AttrDesc &buildAttr, const string &probeFile,
+                           const AttrDesc &probeAttr, const bool buildIsOuter, JoinOutput &out);
+
+// Join method chosen by the cost model for one query
+struct JoinPlan {
+    JoinType method;  // cheapest method
+    bool swap;        // run it with the relations of attr1 and attr2 swapped
+    double cost;      // estimated cost in page I/Os
+};
+
+// choose the cheapest join method for attr1 op attr2 (joinplan.C)
+const Status planJoin(const attrInfo *attr1, const Operator op, const attrInfo *attr2, JoinPlan &plan);
+
+// Equi-join of two heap files by sorting and merging them
+const Status sortMergeJoin(const string &outerFile, const AttrDesc &outerAttr, const string &innerFile,
+                           const AttrDesc &innerAttr, JoinOutput &out);
+
+// the join methods; QU_Join() picks one of them
+const Status QU_NL_Join(const string &result, const int projCnt, const attrInfo projNames[], const attrInfo *attr1,
+                        const Operator op, const attrInfo *attr2);
+const Status QU_BNL_Join(const string &result, const int projCnt, const attrInfo projNames[], const attrInfo *attr1,
+                         const Operator op, const attrInfo *attr2);
+const Status QU_Range_Join(const string &result, const int projCnt, const attrInfo projNames[],
+                           const attrInfo *attr1, const Operator op, const attrInfo *attr2);
+const Status QU_SM_Join(const string &result, const int projCnt, const attrInfo projNames[], const attrInfo *attr1,
+                        const Operator op, const attrInfo *attr2);
+const Status QU_Hash_Join(const string &result, const int projCnt, const attrInfo projNames[], const attrInfo *attr1,
+                          const Operator op, const attrInfo *attr2);
+const Status QU_Grace_Join(const string &result, const int projCnt, const attrInfo projNames[],
+                           const attrInfo *attr1, const Operator op, const attrInfo *attr2);
+const Status QU_Hybrid_Join(const string &result, const int projCnt, const attrInfo projNames[],
+                            const attrInfo *attr1, const Operator op, const attrInfo *attr2);
+const Status QU_Adaptive_Join(const string &result, const int projCnt, const attrInfo projNames[],
+                              const attrInfo *attr1, const Operator op, const attrInfo *attr2);
+const Status QU_Skew_Join(const string &result, const int projCnt, const attrInfo projNames[],
+                          const attrInfo *attr1, const Operator op, const attrInfo *attr2);
+
+#endif
@@ -1,35 +1,81 @@
+#ifndef JOINHT_H
+#define JOINHT_H
+
+#include "catalog.h"
+
+// In-memory hash table used by the hash joins. It maps the join
+// attribute value of a tuple to the tuple's RID.
+//
+// The table uses open addressing with linear probing. Each slot holds
+// the precomputed hash of its key, so most non-matching slots are
+// skipped without comparing keys. Keys are copied into one arena, so
+// inserting a tuple never allocates memory (except when the table has
+// to grow), and probing is done with startProbe()/nextMatch() without
+// allocating anything.
+//
+// A table constructed with tupleLen > 0 keeps a copy of each whole
+// tuple in the arena instead of just the key, for joins whose build
+// tuples do not stay pinned in the buffer pool.
 
 class joinHashTbl {
    private:
-    union JAttrType {
-        int iValue;
-        float fValue;
-        char *sValue;
+    struct HTslot {
+        unsigned int hashValue;  // hash of the key in this slot
+        int entry;               // index into rids[] and keys[], -1 if empty
     };
 
-    struct joinhashBucket {
-        union JAttrType attrValue;
-        RID rid;
-        joinhashBucket *next;  // next node in the hash table
-    };
+    AttrDesc joinAttr;
+    unsigned int seed;  // seed of the hash function
+    int HTSIZE;         // number of slots, always a power of 2
+    HTslot *ht;         // actual hash table
+    int entryCnt;       // number of (key, RID) pairs in the table
+    int maxEntries;     // capacity of rids[] and keys[]
+    int tupleLen;       // length of the tuple copies, 0 if only keys are kept
+    int entryLen;       // bytes per entry in keys[]
+    int keyOffset;      // offset of the key within an entry
+    RID *rids;          // RID of each entry
+    char *keys;         // key (or tuple) arena, entryLen bytes per entry
 
-    struct HTentry {
-        int bucketCnt;          // nuumber of buckets on this chain
-        joinhashBucket *chain;  // pointer to first bucket on the chain
-    };
+    // state of the probe started by startProbe()
+    const char *probeAttr;
+    unsigned int probeHash;
+    int probeSlot;
 
-    AttrDesc joinAttr;
-    int HTSIZE;
-    HTentry *ht;                               // actual hash table
-    int hash(const char *attr, int attrType);  // returns value between 0 and HTSIZE-1
+    bool keyEqual(const char *key, const char *attrPtr) const;
+    Status grow();     // double the capacity and rehash
+    int nextEntry();   // entry of the next match of the probe, -1 if none
 
    public:
-    joinHashTbl(const int size, const AttrDesc attr);  // constructor
+    joinHashTbl(const int size, const AttrDesc attr, const unsigned int seed = 0,
+                const int tupleLen = 0);  // size is the expected number of tuples
     ~joinHashTbl();
 
+    // hash function on join attribute values; also used to partition
+    // relations consistently with the table
+    static unsigned int hash(const char *attrPtr, const int attrType, const int attrLen, const unsigned int seed);
+
     // insert a new (JoinAttrValue, RID) pair into hash table
     Status insert(const RID newRid, const char *tuple);
 
-    // get RIDs of records whose join attribute value matches innerJoinAttrValue
-    Status lookup(const char *innerJoinAttrPtr, int &ridCount, RID *&outRids);
+    // start looking up the RIDs of the tuples whose join attribute
+    // value matches innerJoinAttrPtr
+    void startProbe(const char *innerJoinAttrPtr);
+
+    // return the RID of the next match of the current probe. Returns
+    // OK if a match was found, HASHNOTFOUND if there are no more
+    Status nextMatch(RID &rid);
+
+    // same, also returning the copy of the matching tuple (only for a
+    // table that keeps tuples)
+    Status nextMatch(RID &rid, const char *&tuple);
+
+    // remove all entries but keep the allocated space for reuse
+    void clear();
+
+    // number of (key, RID) pairs in the table
+    int getEntryCnt() const {
+        return entryCnt;
+    }
 };
+
+#endif
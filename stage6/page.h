@@ -17,14 +17,23 @@ struct Record {
 
 // slot structure
 struct slot_t {
-    short offset;
-    short length;  // equals -1 if slot is not in use
+    int offset;
+    int length;  // equals -1 if slot is not in use
 };
 
-const unsigned PAGESIZE = 1024;
-const unsigned DPFIXED = sizeof(slot_t) + 4 * sizeof(short) + 2 * sizeof(int);
-const unsigned PAGEDATASIZE = PAGESIZE - DPFIXED + sizeof(slot_t);
-// size of the data area of a page
+// Sizes of the pages of a database, chosen when it is created: a power
+// of 2 from MINPAGESIZE to MAXPAGESIZE bytes, DEFAULTPAGESIZE unless
+// another size is given.
+#define MINPAGESIZE 4096
+#define MAXPAGESIZE 65536
+#define DEFAULTPAGESIZE 4096
+
+// Size of the pages of the database in use. It is set before the
+// buffer manager is created (see DB::setPageSize) and stays the same
+// from then on.
+extern unsigned pageSize;
+
+const unsigned DPFIXED = sizeof(slot_t) + 6 * sizeof(int);
 
 // Class definition for a minirel data page.
 // The design assumes that records are kept compacted when
@@ -32,17 +41,30 @@ const unsigned PAGEDATASIZE = PAGESIZE - DPFIXED + sizeof(slot_t);
 // array cannot be compacted.  Notice, this class does not keep
 // the records align, relying instead on upper levels to take
 // care of non-aligned attributes
+//
+// A page is pageSize bytes long, so Page objects only exist in the
+// buffer pool and in buffers of that size, never on their own. The
+// fixed fields come first, then the data area, and the slot array
+// fills the data area from its end.
 
 class Page {
    private:
-    char data[PAGESIZE - DPFIXED];
-    slot_t slot[1];   // first element of slot array - grows backwards!
-    short slotCnt;    // number of slots in use;
-    short freePtr;    // offset of first free byte in data[]
-    short freeSpace;  // number of bytes free in data[]
-    short dummy;      // for alignment purposes
-    int nextPage;     // forwards pointer
-    int curPage;      // page number of current pointer
+    int nextPage;   // forwards pointer
+    int curPage;    // page number of current pointer
+    int slotCnt;    // number of slots in use;
+    int freePtr;    // offset of first free byte in data[]
+    int freeSpace;  // number of bytes free in data[]
+    int dummy;      // for alignment purposes
+    char data[1];   // data area, pageSize - DPFIXED + sizeof(slot_t) bytes
+
+    // first element of slot array, in the last bytes of the page -
+    // grows backwards!
+    slot_t *slotArray() {
+        return (slot_t *)((char *)this + pageSize) - 1;
+    }
+    const slot_t *slotArray() const {
+        return (const slot_t *)((const char *)this + pageSize) - 1;
+    }
 
    public:
     void init(const int pageNo);  // initialize a new page
@@ -50,7 +72,7 @@ class Page {
 
     const Status getNextPage(int &pageNo) const;  // returns value of nextPage
     const Status setNextPage(const int pageNo);   // sets value of nextPage to pageNo
-    const short getFreeSpace() const;             // returns amount of free space
+    const int getFreeSpace() const;               // returns amount of free space
 
     // inserts a new record (rec) into the page, returns RID of record
     const Status insertRecord(const Record &rec, RID &rid);
@@ -57,6 +57,7 @@ typedef enum {
     N_LOAD,
     N_PRINT,
     N_HELP,
+    N_BUFSIZE,
     N_SELECT,
     N_JOIN,
     N_PRIMATTR,
@@ -137,6 +138,11 @@ typedef struct node {
 	    char *relname;
 	} HELP;
 
+	// buffer pool size node */
+	struct {
+	    int nbufs;                      // 0 leaves the size as it is
+	} BUFSIZE;
+
 	// select node */
 	struct {
 	    struct node *selattr;
@@ -223,6 +229,7 @@ NODE *drop_node(char *relname, char *attrname);
 NODE *load_node(char *relname, char *filename);
 NODE *print_node(char *relname);
 NODE *help_node(char *relname);
+NODE *bufsize_node(int nbufs);
 NODE *select_node(NODE *selattr, int op, NODE *value);
 NODE *join_node(NODE *joinattr1, int op, NODE *joinattr2);
 NODE *qualattr_node(char *relname, char *attrname);
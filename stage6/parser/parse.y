@@ -13,6 +13,7 @@ extern int yylex();
 extern int yywrap();
 extern void reset_scanner();
 extern void quit();
+extern Error error;
 
 void yyerror(char *);
 
@@ -51,6 +52,7 @@ static NODE *parse_tree;                // root of parse tree
 		RW_OR
 		RW_NOT
 		RW_VALUES	
+		RW_BUFFERS
 		INT_TYPE
 		REAL_TYPE
 		CHAR_TYPE	
@@ -92,6 +94,7 @@ static NODE *parse_tree;                // root of parse tree
 		load
 		print
 		help
+		buffers
 		quit
 		opt_primary_attr
 		opt_where
@@ -155,6 +158,7 @@ command
 	| load
 	| print
 	| help
+	| buffers
 	| quit
 	| nothing
 	{
@@ -316,6 +320,17 @@ help
 	}
 	;
 
+buffers
+	: RW_BUFFERS T_INT
+	{
+		$$ = bufsize_node($2);
+	}
+	| RW_BUFFERS
+	{
+		$$ = bufsize_node(0);
+	}
+	;
+
 quit
 	: RW_QUIT ';'
 	{
@@ -530,8 +545,14 @@ void parse(void)
     fflush(stdout);
 
     // if a query was successfully read, interpret it
-    if(yyparse() == 0 && parse_tree != NULL)
+    if(yyparse() == 0 && parse_tree != NULL) {
       interp(parse_tree);
+
+      // the query is durable once its log records are on disk
+      Status status = db.commit();
+      if (status != OK)
+        error.print(status);
+    }
   }
 }
 
@@ -78,22 +78,23 @@ extern int yydebug;
     RW_OR = 279,                   /* RW_OR  */
     RW_NOT = 280,                  /* RW_NOT  */
     RW_VALUES = 281,               /* RW_VALUES  */
-    INT_TYPE = 282,                /* INT_TYPE  */
-    REAL_TYPE = 283,               /* REAL_TYPE  */
-    CHAR_TYPE = 284,               /* CHAR_TYPE  */
-    T_EQ = 285,                    /* T_EQ  */
-    T_LT = 286,                    /* T_LT  */
-    T_LE = 287,                    /* T_LE  */
-    T_GT = 288,                    /* T_GT  */
-    T_GE = 289,                    /* T_GE  */
-    T_NE = 290,                    /* T_NE  */
-    T_EOF = 291,                   /* T_EOF  */
-    NOTOKEN = 292,                 /* NOTOKEN  */
-    T_INT = 293,                   /* T_INT  */
-    T_REAL = 294,                  /* T_REAL  */
-    T_STRING = 295,                /* T_STRING  */
-    T_QSTRING = 296,               /* T_QSTRING  */
-    T_SHELL_CMD = 297              /* T_SHELL_CMD  */
+    RW_BUFFERS = 282,              /* RW_BUFFERS  */
+    INT_TYPE = 283,                /* INT_TYPE  */
+    REAL_TYPE = 284,               /* REAL_TYPE  */
+    CHAR_TYPE = 285,               /* CHAR_TYPE  */
+    T_EQ = 286,                    /* T_EQ  */
+    T_LT = 287,                    /* T_LT  */
+    T_LE = 288,                    /* T_LE  */
+    T_GT = 289,                    /* T_GT  */
+    T_GE = 290,                    /* T_GE  */
+    T_NE = 291,                    /* T_NE  */
+    T_EOF = 292,                   /* T_EOF  */
+    NOTOKEN = 293,                 /* NOTOKEN  */
+    T_INT = 294,                   /* T_INT  */
+    T_REAL = 295,                  /* T_REAL  */
+    T_STRING = 296,                /* T_STRING  */
+    T_QSTRING = 297,               /* T_QSTRING  */
+    T_SHELL_CMD = 298              /* T_SHELL_CMD  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -126,35 +127,36 @@ extern int yydebug;
 #define RW_OR 279
 #define RW_NOT 280
 #define RW_VALUES 281
-#define INT_TYPE 282
-#define REAL_TYPE 283
-#define CHAR_TYPE 284
-#define T_EQ 285
-#define T_LT 286
-#define T_LE 287
-#define T_GT 288
-#define T_GE 289
-#define T_NE 290
-#define T_EOF 291
-#define NOTOKEN 292
-#define T_INT 293
-#define T_REAL 294
-#define T_STRING 295
-#define T_QSTRING 296
-#define T_SHELL_CMD 297
+#define RW_BUFFERS 282
+#define INT_TYPE 283
+#define REAL_TYPE 284
+#define CHAR_TYPE 285
+#define T_EQ 286
+#define T_LT 287
+#define T_LE 288
+#define T_GT 289
+#define T_GE 290
+#define T_NE 291
+#define T_EOF 292
+#define NOTOKEN 293
+#define T_INT 294
+#define T_REAL 295
+#define T_STRING 296
+#define T_QSTRING 297
+#define T_SHELL_CMD 298
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 23 "parse.y"
+#line 24 "parse.y"
 
   int ival;
   float rval;
   char *sval;
   NODE *n;
 
-#line 158 "y.tab.h"
+#line 160 "y.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -3,7 +3,7 @@
 
 #include "heapfile.h"
 
-enum JoinType { NLJoin, SMJoin, HashJoin };
+enum JoinType { NLJoin, SMJoin, HashJoin, GraceJoin, HybridJoin, BNLJoin, RangeJoin, AutoJoin, AdaptiveJoin, SkewJoin };
 
 //
 // Prototypes for query layer functions
@@ -52,6 +52,7 @@ class SortedFile {
     Datatype type;      // type of sort attribute
     int offset;         // offset of sort attribute
     int length;         // length of sort attribute
+    int sortId;         // distinguishes run files of concurrent sorts
 
     SORTREC *buffer;  // in-memory sort buffer
     int maxItems;     // max. # of items/tuples in buffer
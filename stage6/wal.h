@@ -0,0 +1,99 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "error.h"
+using namespace std;
+
+class Page;
+
+// name of the log in the database directory
+#define LOGFILE "minirel.log"
+
+// bytes of log records buffered before they are written even without
+// a commit
+#define LOGBUFSIZE (256 * 1024)
+
+// size the log may grow to before a checkpoint at the next commit
+#define LOGCHECKPOINTSIZE (8 * 1024 * 1024)
+
+// kinds of log records
+enum LogType { LOGCREATE, LOGDESTROY, LOGALLOC, LOGFREE, LOGPAGE, LOGCOMMIT };
+
+// Header of a log record. It is followed by the name of the file and,
+// in a LOGPAGE record, the image of the page. A LOGCOMMIT record ends
+// the records of a statement and names no file.
+struct LogRecord {
+    int type;               // LogType
+    int length;             // bytes of the record, header included
+    unsigned int checksum;  // of the record, with checksum 0
+    int nameLen;            // bytes of the file name that follows
+    int pageNo;             // LOGALLOC, LOGFREE, LOGPAGE: (first) page
+    int count;              // LOGALLOC, LOGFREE: number of pages
+};
+
+// Write-ahead log of a database. Changes are appended to a buffer and
+// given a log sequence number (LSN), the log offset right after their
+// record, counted from the start of the process. Before a changed page
+// may be written to its file, the log must be on disk up to the page's
+// LSN (see force).
+//
+// The log holds redo records only: the files created and destroyed,
+// the pages allocated and disposed of, and the image a page has when
+// it is unpinned dirty. Each statement that logged anything ends with a
+// commit record. Replaying the log from its start after a crash, up to
+// the last commit record on disk, brings every file back to the state
+// of the last statement committed. A checkpoint writes all pages and
+// file headers back, after which the log drops the records appended
+// before it started.
+class LogMgr {
+   public:
+    LogMgr();
+    ~LogMgr();
+
+    const Status open();  // open or create the log in the current directory
+
+    // append a record; returns its LSN in lsn
+    const Status logCreate(const string &fileName, long &lsn);
+    const Status logDestroy(const string &fileName, long &lsn);
+    const Status logAlloc(const string &fileName, const int pageNo, long &lsn);
+    const Status logFree(const string &fileName, const int pageNo, long &lsn);
+    const Status logPage(const string &fileName, const int pageNo, const Page *page, long &lsn);
+
+    // Make sure the log is on disk up to lsn. Threads that wait while
+    // the log is being written get their records written together by
+    // the next of them, with a single fsync: a group commit.
+    const Status force(const long lsn);
+    // end a statement: append a commit record and force the log up to it
+    const Status commit();
+
+    bool full() const;  // the log has grown past LOGCHECKPOINTSIZE
+    long end();         // LSN after the last record appended
+    // Drop the records up to lsn, after a checkpoint that began there;
+    // records appended since are kept, on disk or in the buffer.
+    const Status truncate(const long lsn);
+
+    // Read the record at offset of the log file into rec, name and page
+    // (for LOGPAGE records). offset moves to the next record. Returns
+    // FILEEOF at the end of the log or at a torn record.
+    const Status read(long &offset, LogRecord &rec, string &name, Page *page);
+
+   private:
+    const Status append(LogRecord &rec, const string &fileName, const Page *page, long &lsn);
+
+    int fd;               // the log file
+    long fileSize;        // bytes of the log file, written or buffered
+    long start;           // LSN of the first byte of the log file
+    vector<char> buffer;  // records appended but not written
+    long appended;        // LSN after the last record appended
+    long durable;         // LSN up to which the log is on disk
+    long committed;       // LSN of the last commit record
+    bool writing;         // a thread is writing the log
+    mutex latch;          // protects all of the above
+    condition_variable written;
+};
+
+#endif